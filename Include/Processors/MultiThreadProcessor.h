@@ -1,5 +1,7 @@
 #pragma once
 #include <Core/ImageProcessor.h>
+#include <Utils/CostModelPartitioner.h>
+#include <Utils/HardwareCounters.h>
 #include <Utils/ThreadPool.h>
 
 class MultiThreadProcessor : public ImageProcessor
@@ -12,16 +14,52 @@ public:
         JThread
     };
 
-    explicit MultiThreadProcessor(int numThreads, ThreadingStrategy strategy = ThreadingStrategy::ThreadPool);
+    enum class PartitionStrategy
+    {
+        Uniform,
+        CostModel
+    };
+
+    explicit MultiThreadProcessor(int numThreads, ThreadingStrategy strategy = ThreadingStrategy::ThreadPool,
+                                  PartitionStrategy partition = PartitionStrategy::Uniform);
 
     cv::Mat process(const cv::Mat& inputImage) override;
 
     std::vector<cv::Rect> divideImageIntoRegions(const cv::Mat& image) const;
 
+    void setPartitionStrategy(PartitionStrategy partition);
+
+    // Fits the cost model to the tiles and times of the last process() call on this image.
+    void calibrateCostModel(const cv::Mat& image);
+
+    const std::vector<cv::Rect>& getLastRegions() const;
+
+    const std::vector<double>& getTileTimes() const;
+
+    void setCounterCollection(bool enabled);
+
+    // Totals of the last process() call: every tile plus the coordinating thread.
+    const HardwareCounters::Sample& getRunCounters() const;
+
+    const std::vector<HardwareCounters::Sample>& getTileCounters() const;
+
 private:
     int mNumThreads;
     ThreadingStrategy mStrategy;
+    PartitionStrategy mPartition;
     std::unique_ptr<ThreadPool> mThreadPool;
+    CostModelPartitioner mPartitioner;
+    std::vector<cv::Rect> mLastRegions;
+    std::vector<double> mTileTimes;
+    bool mCollectCounters = false;
+    HardwareCounters::Sample mRunCounters;
+    std::vector<HardwareCounters::Sample> mTileCounters;
+
+    std::vector<cv::Rect> divideIntoUniformGrid(const cv::Mat& image) const;
+
+    std::vector<cv::Rect> prepareRegions(const cv::Mat& image);
+
+    void processRegion(cv::Mat& image, const cv::Rect& region, size_t index);
 
     cv::Mat processWithThreadPool(const cv::Mat& inputImage);
 
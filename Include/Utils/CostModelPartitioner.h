@@ -0,0 +1,27 @@
+#pragma once
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+// Splits an image into regions of roughly equal predicted filter cost instead of equal area.
+// The cost of a pixel is modelled as 1 + weight * edgeDensity, where edge density is the gradient
+// magnitude of a downsampled copy of the image normalised to a mean of 1. The regions come from
+// recursive bisection of that cost map, and calibrate() fits the weight to measured tile times,
+// falling back to area-only weights when edge density does not explain those times better.
+class CostModelPartitioner
+{
+public:
+    explicit CostModelPartitioner(double edgeWeight = 1.0);
+
+    std::vector<cv::Rect> partition(const cv::Mat& image, int numRegions) const;
+
+    void calibrate(const cv::Mat& image, const std::vector<cv::Rect>& regions, const std::vector<double>& tileTimes);
+
+    double getEdgeWeight() const;
+
+private:
+    double mEdgeWeight;
+
+    static cv::Mat buildEdgeMap(const cv::Mat& image);
+
+    cv::Mat buildCostMap(const cv::Mat& image) const;
+};
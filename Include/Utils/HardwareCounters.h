@@ -0,0 +1,68 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Thin wrapper over Linux perf_event_open that counts events for the calling thread only.
+// Every event is opened independently, so a missing PMU or a restrictive perf_event_paranoid
+// setting simply leaves that event unavailable; on other platforms nothing is ever available.
+// Under perf_event_paranoid >= 2 hardware events fall back to user-space-only counting, which
+// the sample records per event; scheduler events are raised in the kernel and have no such mode.
+class HardwareCounters
+{
+public:
+    enum class Event
+    {
+        Cycles,
+        Instructions,
+        LlcMisses,
+        ContextSwitches,
+        CpuMigrations,
+        Count
+    };
+
+    static constexpr size_t kNumEvents = static_cast<size_t>(Event::Count);
+
+    struct Sample
+    {
+        std::array<uint64_t, kNumEvents> values{};
+        std::array<bool, kNumEvents> available{};
+        std::array<bool, kNumEvents> userOnly{};
+
+        bool has(Event event) const;
+
+        bool isUserOnly(Event event) const;
+
+        bool anyUserOnly() const;
+
+        uint64_t get(Event event) const;
+
+        bool hasAny() const;
+
+        double ipc() const;
+
+        Sample& operator+=(const Sample& other);
+    };
+
+    HardwareCounters();
+
+    ~HardwareCounters();
+
+    HardwareCounters(const HardwareCounters&) = delete;
+    HardwareCounters& operator=(const HardwareCounters&) = delete;
+
+    void start();
+
+    Sample stop();
+
+    static bool isSupported();
+
+    static const std::string& unavailableReason();
+
+    static const char* eventName(Event event);
+
+private:
+    std::array<int, kNumEvents> mFds;
+    std::array<bool, kNumEvents> mUserOnly;
+};
@@ -1,8 +1,10 @@
 #pragma once
+#include <Utils/HardwareCounters.h>
 #include <chrono>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 class PerformanceMetrics
 {
@@ -19,10 +21,25 @@ public:
 
     double calculateEfficiency(const std::string& baseline, const std::string& comparison, int numThreads) const;
 
+    void recordCounters(const std::string& name, const HardwareCounters::Sample& sample);
+
+    void recordTileCounters(const std::string& name, const std::vector<HardwareCounters::Sample>& samples);
+
+    void recordTileTimes(const std::string& name, const std::vector<double>& seconds);
+
     void printMetrics(int numThreads) const;
 
+    void exportReport(const std::string& filename, int numThreads, const std::string& strategy) const;
+
 private:
+    void printCounters(const std::string& name) const;
+
+    void printLoadBalance(int numThreads) const;
+
     std::chrono::time_point<std::chrono::high_resolution_clock> mStartTime;
     std::unordered_map<std::string, double> mElapsedTimes;
+    std::unordered_map<std::string, HardwareCounters::Sample> mCounters;
+    std::unordered_map<std::string, std::vector<HardwareCounters::Sample>> mTileCounters;
+    std::unordered_map<std::string, std::vector<double>> mTileTimes;
     mutable std::mutex mMutex;
 };
@@ -0,0 +1,268 @@
+#include <Utils/CostModelPartitioner.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <utility>
+
+namespace
+{
+
+// Longest side of the downsampled cost grid; keeps the cost map far cheaper than the filter itself.
+constexpr int kMaxGridSize = 128;
+constexpr double kMaxEdgeWeight = 10.0;
+
+struct CellRect
+{
+    int x0, y0, x1, y1;
+
+    int width() const
+    {
+        return x1 - x0;
+    }
+
+    int height() const
+    {
+        return y1 - y0;
+    }
+};
+
+class GridPrefixSum
+{
+public:
+    explicit GridPrefixSum(const cv::Mat& grid) : mCols(grid.cols), mSums((grid.rows + 1) * (grid.cols + 1), 0.0)
+    {
+        for (int y = 0; y < grid.rows; y++)
+        {
+            for (int x = 0; x < grid.cols; x++)
+            {
+                at(x + 1, y + 1) = grid.at<float>(y, x) + at(x, y + 1) + at(x + 1, y) - at(x, y);
+            }
+        }
+    }
+
+    double sum(const CellRect& r) const
+    {
+        return at(r.x1, r.y1) - at(r.x0, r.y1) - at(r.x1, r.y0) + at(r.x0, r.y0);
+    }
+
+private:
+    int mCols;
+    std::vector<double> mSums;
+
+    double& at(int x, int y)
+    {
+        return mSums[y * (mCols + 1) + x];
+    }
+
+    double at(int x, int y) const
+    {
+        return mSums[y * (mCols + 1) + x];
+    }
+};
+
+CellRect toCells(const cv::Rect& region, const cv::Mat& image, const cv::Mat& grid)
+{
+    auto toCell = [](int pixel, int pixels, int cells)
+    { return std::clamp(static_cast<int>(std::lround(static_cast<double>(pixel) * cells / pixels)), 0, cells); };
+
+    CellRect cells{toCell(region.x, image.cols, grid.cols), toCell(region.y, image.rows, grid.rows),
+                   toCell(region.x + region.width, image.cols, grid.cols),
+                   toCell(region.y + region.height, image.rows, grid.rows)};
+
+    cells.x1 = std::max(cells.x1, std::min(cells.x0 + 1, grid.cols));
+    cells.y1 = std::max(cells.y1, std::min(cells.y0 + 1, grid.rows));
+    return cells;
+}
+
+cv::Rect toPixels(const CellRect& cells, const cv::Mat& image, const cv::Mat& grid)
+{
+    int x0 = cells.x0 * image.cols / grid.cols;
+    int y0 = cells.y0 * image.rows / grid.rows;
+    int x1 = cells.x1 * image.cols / grid.cols;
+    int y1 = cells.y1 * image.rows / grid.rows;
+    return {x0, y0, x1 - x0, y1 - y0};
+}
+
+void bisect(const GridPrefixSum& prefix, const CellRect& cells, int count, std::vector<CellRect>& out)
+{
+    if (count <= 1 || (cells.width() <= 1 && cells.height() <= 1))
+    {
+        out.push_back(cells);
+        return;
+    }
+
+    int firstCount = count / 2;
+    double target = prefix.sum(cells) * firstCount / count;
+
+    // Cut across the longer side so regions stay close to square, like the uniform grid.
+    bool splitColumns = cells.width() >= cells.height();
+    int length = splitColumns ? cells.width() : cells.height();
+
+    auto splitAt = [&](int split)
+    {
+        CellRect first = cells;
+        CellRect second = cells;
+        if (splitColumns)
+        {
+            first.x1 = second.x0 = cells.x0 + split;
+        }
+        else
+        {
+            first.y1 = second.y0 = cells.y0 + split;
+        }
+        return std::make_pair(first, second);
+    };
+
+    int bestSplit = 1;
+    double bestError = std::abs(prefix.sum(splitAt(1).first) - target);
+    for (int split = 2; split < length; split++)
+    {
+        double error = std::abs(prefix.sum(splitAt(split).first) - target);
+        if (error < bestError)
+        {
+            bestError = error;
+            bestSplit = split;
+        }
+    }
+
+    auto [first, second] = splitAt(bestSplit);
+    bisect(prefix, first, firstCount, out);
+    bisect(prefix, second, count - firstCount, out);
+}
+
+} // namespace
+
+CostModelPartitioner::CostModelPartitioner(double edgeWeight) : mEdgeWeight(edgeWeight)
+{
+}
+
+std::vector<cv::Rect> CostModelPartitioner::partition(const cv::Mat& image, int numRegions) const
+{
+    cv::Mat costMap = buildCostMap(image);
+    GridPrefixSum prefix(costMap);
+
+    std::vector<CellRect> cells;
+    cells.reserve(numRegions);
+    bisect(prefix, {0, 0, costMap.cols, costMap.rows}, numRegions, cells);
+
+    std::vector<cv::Rect> regions;
+    regions.reserve(cells.size());
+    for (const auto& cell : cells)
+    {
+        regions.push_back(toPixels(cell, image, costMap));
+    }
+
+    std::cout << "Partitioning into " << regions.size() << " cost-balanced regions (edge weight " << mEdgeWeight
+              << ")" << std::endl;
+
+    return regions;
+}
+
+void CostModelPartitioner::calibrate(const cv::Mat& image, const std::vector<cv::Rect>& regions,
+                                     const std::vector<double>& tileTimes)
+{
+    // Two parameters are fitted, so at least one extra tile is needed before the residual says anything.
+    if (regions.size() <= 2 || regions.size() != tileTimes.size())
+    {
+        std::cout << "Cost model calibration skipped: " << tileTimes.size()
+                  << " tiles are too few to fit, keeping edge weight " << mEdgeWeight << std::endl;
+        return;
+    }
+
+    cv::Mat edgeMap = buildEdgeMap(image);
+    GridPrefixSum prefix(edgeMap);
+    double cellsPerPixel = static_cast<double>(edgeMap.total()) / static_cast<double>(image.total());
+
+    // Least-squares fit of time = alpha * area + beta * edges; the model only needs beta / alpha.
+    double sumAA = 0, sumAE = 0, sumEE = 0, sumAT = 0, sumET = 0, sumTT = 0;
+    for (size_t i = 0; i < regions.size(); i++)
+    {
+        double area = regions[i].area() * cellsPerPixel;
+        double edges = prefix.sum(toCells(regions[i], image, edgeMap));
+
+        sumAA += area * area;
+        sumAE += area * edges;
+        sumEE += edges * edges;
+        sumAT += area * tileTimes[i];
+        sumET += edges * tileTimes[i];
+        sumTT += tileTimes[i] * tileTimes[i];
+    }
+
+    double det = sumAA * sumEE - sumAE * sumAE;
+    if (sumAA <= 0 || det <= 1e-9 * sumAA * sumEE)
+    {
+        // Area and edge density are collinear across these tiles, so they cannot be told apart.
+        std::cout << "Cost model calibration skipped: area and edge density are collinear across tiles, keeping "
+                     "edge weight "
+                  << mEdgeWeight << std::endl;
+        return;
+    }
+
+    double alpha = (sumAT * sumEE - sumET * sumAE) / det;
+    double beta = (sumET * sumAA - sumAT * sumAE) / det;
+
+    // Residuals of the area-only fit (time = a * area) and of the two-parameter fit, compared per degree of
+    // freedom so the extra parameter has to earn its place rather than just absorb timing jitter.
+    double n = static_cast<double>(regions.size());
+    double areaOnlyResidual = std::max(0.0, sumTT - sumAT * sumAT / sumAA) / (n - 1.0);
+    double edgeResidual = std::max(0.0, sumTT - alpha * sumAT - beta * sumET) / (n - 2.0);
+
+    if (alpha <= 0 || beta <= 0 || edgeResidual >= areaOnlyResidual)
+    {
+        mEdgeWeight = 0.0;
+        std::cout << "Cost model calibration rejected: edge density does not explain tile times better than area, "
+                     "using area-only weights"
+                  << std::endl;
+        return;
+    }
+
+    mEdgeWeight = std::min(beta / alpha, kMaxEdgeWeight);
+    std::cout << "Cost model calibration accepted: edge weight " << mEdgeWeight << std::endl;
+}
+
+double CostModelPartitioner::getEdgeWeight() const
+{
+    return mEdgeWeight;
+}
+
+cv::Mat CostModelPartitioner::buildEdgeMap(const cv::Mat& image)
+{
+    double scale = std::min(1.0, static_cast<double>(kMaxGridSize) / std::max(image.cols, image.rows));
+    cv::Size gridSize(std::max(1, static_cast<int>(std::lround(image.cols * scale))),
+                      std::max(1, static_cast<int>(std::lround(image.rows * scale))));
+
+    cv::Mat small;
+    cv::resize(image, small, gridSize, 0, 0, cv::INTER_AREA);
+
+    cv::Mat gray;
+    if (small.channels() == 3)
+    {
+        cv::cvtColor(small, gray, cv::COLOR_BGR2GRAY);
+    }
+    else
+    {
+        gray = small;
+    }
+
+    cv::Mat grayF;
+    gray.convertTo(grayF, CV_32F);
+
+    cv::Mat gradX, gradY, edges;
+    cv::Sobel(grayF, gradX, CV_32F, 1, 0);
+    cv::Sobel(grayF, gradY, CV_32F, 0, 1);
+    cv::magnitude(gradX, gradY, edges);
+
+    double meanEdge = cv::mean(edges)[0];
+    if (meanEdge > 0)
+    {
+        edges /= meanEdge;
+    }
+
+    return edges;
+}
+
+cv::Mat CostModelPartitioner::buildCostMap(const cv::Mat& image) const
+{
+    cv::Mat costMap = buildEdgeMap(image) * mEdgeWeight + 1.0;
+    return costMap;
+}
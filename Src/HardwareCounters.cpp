@@ -0,0 +1,268 @@
+#include <Utils/HardwareCounters.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+
+struct ProbeResult
+{
+    bool supported = false;
+    std::string reason;
+};
+
+#ifdef __linux__
+struct EventConfig
+{
+    uint32_t type;
+    uint64_t config;
+};
+
+constexpr std::array<EventConfig, HardwareCounters::kNumEvents> kEventConfigs = {{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS},
+}};
+
+int openEvent(const EventConfig& event, bool excludeKernel)
+{
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.disabled = 1;
+    attr.exclude_kernel = excludeKernel ? 1 : 0;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    // pid = 0, cpu = -1: follow the calling thread on whichever CPU it runs.
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+int openEventWithFallback(const EventConfig& event, bool& userOnly)
+{
+    userOnly = false;
+    int fd = openEvent(event, false);
+
+    // perf_event_paranoid >= 2 only permits user-space counting. Context switches and migrations happen in the
+    // kernel and would always read 0 that way, so only hardware events take the user-only fallback.
+    if (fd < 0 && (errno == EACCES || errno == EPERM) && event.type == PERF_TYPE_HARDWARE)
+    {
+        fd = openEvent(event, true);
+        userOnly = fd >= 0;
+    }
+    return fd;
+}
+#endif
+
+const ProbeResult& probe()
+{
+    static const ProbeResult result = []
+    {
+        ProbeResult probeResult;
+#ifdef __linux__
+        for (const auto& event : kEventConfigs)
+        {
+            bool userOnly = false;
+            int fd = openEventWithFallback(event, userOnly);
+            if (fd >= 0)
+            {
+                close(fd);
+                probeResult.supported = true;
+            }
+            else if (probeResult.reason.empty())
+            {
+                probeResult.reason = std::string("perf_event_open failed: ") + std::strerror(errno);
+            }
+        }
+#else
+        probeResult.reason = "perf_event_open is only available on Linux";
+#endif
+        if (probeResult.supported)
+        {
+            probeResult.reason.clear();
+        }
+        return probeResult;
+    }();
+    return result;
+}
+
+} // namespace
+
+bool HardwareCounters::Sample::has(Event event) const
+{
+    return available[static_cast<size_t>(event)];
+}
+
+uint64_t HardwareCounters::Sample::get(Event event) const
+{
+    return values[static_cast<size_t>(event)];
+}
+
+bool HardwareCounters::Sample::isUserOnly(Event event) const
+{
+    return userOnly[static_cast<size_t>(event)];
+}
+
+bool HardwareCounters::Sample::anyUserOnly() const
+{
+    for (size_t i = 0; i < kNumEvents; ++i)
+    {
+        if (available[i] && userOnly[i])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool HardwareCounters::Sample::hasAny() const
+{
+    return std::any_of(available.begin(), available.end(), [](bool value) { return value; });
+}
+
+double HardwareCounters::Sample::ipc() const
+{
+    if (has(Event::Cycles) && has(Event::Instructions) && get(Event::Cycles) > 0)
+    {
+        return static_cast<double>(get(Event::Instructions)) / static_cast<double>(get(Event::Cycles));
+    }
+    return 0.0;
+}
+
+HardwareCounters::Sample& HardwareCounters::Sample::operator+=(const Sample& other)
+{
+    for (size_t i = 0; i < kNumEvents; ++i)
+    {
+        if (other.available[i])
+        {
+            values[i] += other.values[i];
+            available[i] = true;
+            userOnly[i] = userOnly[i] || other.userOnly[i];
+        }
+    }
+    return *this;
+}
+
+HardwareCounters::HardwareCounters()
+{
+    mFds.fill(-1);
+    mUserOnly.fill(false);
+
+#ifdef __linux__
+    if (!isSupported())
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < kNumEvents; ++i)
+    {
+        mFds[i] = openEventWithFallback(kEventConfigs[i], mUserOnly[i]);
+    }
+#endif
+}
+
+HardwareCounters::~HardwareCounters()
+{
+#ifdef __linux__
+    for (int fd : mFds)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+#endif
+}
+
+void HardwareCounters::start()
+{
+#ifdef __linux__
+    for (int fd : mFds)
+    {
+        if (fd >= 0)
+        {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+HardwareCounters::Sample HardwareCounters::stop()
+{
+    Sample sample;
+
+#ifdef __linux__
+    for (int fd : mFds)
+    {
+        if (fd >= 0)
+        {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+
+    for (size_t i = 0; i < kNumEvents; ++i)
+    {
+        if (mFds[i] < 0)
+        {
+            continue;
+        }
+
+        // value, time_enabled, time_running
+        uint64_t data[3] = {0, 0, 0};
+        if (read(mFds[i], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0)
+        {
+            continue;
+        }
+
+        // Scale up when the PMU had to multiplex this event with others.
+        double scale = static_cast<double>(data[1]) / static_cast<double>(data[2]);
+        sample.values[i] = static_cast<uint64_t>(static_cast<double>(data[0]) * scale);
+        sample.available[i] = true;
+        sample.userOnly[i] = mUserOnly[i];
+    }
+#endif
+
+    return sample;
+}
+
+bool HardwareCounters::isSupported()
+{
+    return probe().supported;
+}
+
+const std::string& HardwareCounters::unavailableReason()
+{
+    return probe().reason;
+}
+
+const char* HardwareCounters::eventName(Event event)
+{
+    switch (event)
+    {
+    case Event::Cycles:
+        return "Cycles";
+    case Event::Instructions:
+        return "Instructions";
+    case Event::LlcMisses:
+        return "LLC misses";
+    case Event::ContextSwitches:
+        return "Context switches";
+    case Event::CpuMigrations:
+        return "CPU migrations";
+    default:
+        return "Unknown";
+    }
+}
@@ -1,8 +1,9 @@
 #include <Processors/MultiThreadProcessor.h>
+#include <chrono>
 #include <latch>
 
-MultiThreadProcessor::MultiThreadProcessor(int numThreads, ThreadingStrategy strategy)
-    : mNumThreads(numThreads), mStrategy(strategy)
+MultiThreadProcessor::MultiThreadProcessor(int numThreads, ThreadingStrategy strategy, PartitionStrategy partition)
+    : mNumThreads(numThreads), mStrategy(strategy), mPartition(partition)
 {
     if (strategy == ThreadingStrategy::ThreadPool)
     {
@@ -12,23 +13,125 @@ MultiThreadProcessor::MultiThreadProcessor(int numThreads, ThreadingStrategy str
 
 cv::Mat MultiThreadProcessor::process(const cv::Mat& inputImage)
 {
+    mRunCounters = {};
+    mTileCounters.clear();
+
+    std::unique_ptr<HardwareCounters> coordinatorCounters;
+    if (mCollectCounters)
+    {
+        coordinatorCounters = std::make_unique<HardwareCounters>();
+        coordinatorCounters->start();
+    }
+
+    cv::Mat outputImage;
     switch (mStrategy)
     {
     case ThreadingStrategy::ThreadPool:
-        return processWithThreadPool(inputImage);
+        outputImage = processWithThreadPool(inputImage);
+        break;
 
     case ThreadingStrategy::Async:
-        return processWithAsync(inputImage);
+        outputImage = processWithAsync(inputImage);
+        break;
 
     case ThreadingStrategy::JThread:
-        return processWithJThreads(inputImage);
+        outputImage = processWithJThreads(inputImage);
+        break;
 
     default:
-        return processWithAsync(inputImage);
+        outputImage = processWithAsync(inputImage);
+        break;
     }
+
+    if (coordinatorCounters)
+    {
+        mRunCounters = coordinatorCounters->stop();
+        for (const auto& tile : mTileCounters)
+        {
+            mRunCounters += tile;
+        }
+    }
+
+    return outputImage;
+}
+
+void MultiThreadProcessor::setCounterCollection(bool enabled)
+{
+    mCollectCounters = enabled;
+}
+
+const HardwareCounters::Sample& MultiThreadProcessor::getRunCounters() const
+{
+    return mRunCounters;
+}
+
+const std::vector<HardwareCounters::Sample>& MultiThreadProcessor::getTileCounters() const
+{
+    return mTileCounters;
+}
+
+void MultiThreadProcessor::processRegion(cv::Mat& image, const cv::Rect& region, size_t index)
+{
+    // Opened on the worker itself so the counters follow exactly the thread doing this tile, and before the
+    // clock starts so the perf_event_open calls do not inflate the tile time.
+    std::unique_ptr<HardwareCounters> counters;
+    if (mCollectCounters)
+    {
+        counters = std::make_unique<HardwareCounters>();
+        counters->start();
+    }
+
+    auto startTime = std::chrono::high_resolution_clock::now();
+    applyHeavyFilter(image, region);
+    auto endTime = std::chrono::high_resolution_clock::now();
+
+    if (counters)
+    {
+        mTileCounters[index] = counters->stop();
+    }
+
+    mTileTimes[index] = std::chrono::duration<double>(endTime - startTime).count();
 }
 
 std::vector<cv::Rect> MultiThreadProcessor::divideImageIntoRegions(const cv::Mat& image) const
+{
+    if (mPartition == PartitionStrategy::CostModel)
+    {
+        return mPartitioner.partition(image, mNumThreads);
+    }
+
+    return divideIntoUniformGrid(image);
+}
+
+void MultiThreadProcessor::setPartitionStrategy(PartitionStrategy partition)
+{
+    mPartition = partition;
+}
+
+void MultiThreadProcessor::calibrateCostModel(const cv::Mat& image)
+{
+    mPartitioner.calibrate(image, mLastRegions, mTileTimes);
+}
+
+const std::vector<cv::Rect>& MultiThreadProcessor::getLastRegions() const
+{
+    return mLastRegions;
+}
+
+const std::vector<double>& MultiThreadProcessor::getTileTimes() const
+{
+    return mTileTimes;
+}
+
+std::vector<cv::Rect> MultiThreadProcessor::prepareRegions(const cv::Mat& image)
+{
+    mLastRegions = divideImageIntoRegions(image);
+    mTileTimes.assign(mLastRegions.size(), 0.0);
+    mTileCounters.assign(mLastRegions.size(), {});
+    return mLastRegions;
+}
+
+std::vector<cv::Rect> MultiThreadProcessor::divideIntoUniformGrid(const cv::Mat& image) const
 {
     std::vector<cv::Rect> regions;
     regions.reserve(mNumThreads);
@@ -79,14 +182,15 @@ cv::Mat MultiThreadProcessor::processWithThreadPool(const cv::Mat& inputImage)
 {
     cv::Mat outputImage = inputImage.clone();
 
-    std::vector<cv::Rect> regions = divideImageIntoRegions(outputImage);
+    std::vector<cv::Rect> regions = prepareRegions(outputImage);
 
     std::vector<std::future<void>> results;
     results.reserve(regions.size());
 
-    for (const auto& region : regions)
+    for (size_t i = 0; i < regions.size(); i++)
     {
-        results.push_back(mThreadPool->enqueue([&outputImage, region]() { applyHeavyFilter(outputImage, region); }));
+        results.push_back(mThreadPool->enqueue([this, &outputImage, &regions, i]()
+                                               { processRegion(outputImage, regions[i], i); }));
     }
 
     for (auto& result : results)
@@ -101,15 +205,15 @@ cv::Mat MultiThreadProcessor::processWithAsync(const cv::Mat& inputImage)
 {
     cv::Mat outputImage = inputImage.clone();
 
-    std::vector<cv::Rect> regions = divideImageIntoRegions(outputImage);
+    std::vector<cv::Rect> regions = prepareRegions(outputImage);
 
     std::vector<std::future<void>> futures;
     futures.reserve(regions.size());
 
-    for (const auto& region : regions)
+    for (size_t i = 0; i < regions.size(); i++)
     {
-        futures.push_back(
-            std::async(std::launch::async, [&outputImage, region]() { applyHeavyFilter(outputImage, region); }));
+        futures.push_back(std::async(std::launch::async, [this, &outputImage, &regions, i]()
+                                     { processRegion(outputImage, regions[i], i); }));
     }
 
     for (auto& future : futures)
@@ -124,19 +228,19 @@ cv::Mat MultiThreadProcessor::processWithJThreads(const cv::Mat& inputImage)
 {
     cv::Mat outputImage = inputImage.clone();
 
-    std::vector<cv::Rect> regions = divideImageIntoRegions(outputImage);
+    std::vector<cv::Rect> regions = prepareRegions(outputImage);
 
     std::latch completionLatch(regions.size());
 
     std::vector<std::jthread> threads;
     threads.reserve(regions.size());
 
-    for (const auto& region : regions)
+    for (size_t i = 0; i < regions.size(); i++)
     {
         threads.emplace_back(
-            [&outputImage, region, &completionLatch]()
+            [this, &outputImage, &regions, i, &completionLatch]()
             {
-                applyHeavyFilter(outputImage, region);
+                processRegion(outputImage, regions[i], i);
                 completionLatch.count_down();
             });
     }
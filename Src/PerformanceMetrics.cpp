@@ -1,8 +1,81 @@
 #include <Utils/PerformanceMetrics.h>
 #include <algorithm>
+#include <fstream>
 #include <iomanip>
 #include <iostream>
 
+namespace
+{
+
+constexpr HardwareCounters::Event kReportedEvents[] = {
+    HardwareCounters::Event::Cycles, HardwareCounters::Event::Instructions, HardwareCounters::Event::LlcMisses,
+    HardwareCounters::Event::ContextSwitches, HardwareCounters::Event::CpuMigrations};
+
+constexpr int kTileColumnWidths[] = {16, 16, 12, 8, 8};
+
+// Runs reported in order; "UniformGrid" is only present when it was measured as a partitioning baseline.
+const std::string kReportedRuns[] = {"SingleThread", "UniformGrid", "MultiThread"};
+
+struct LoadBalance
+{
+    double makespan = 0.0;
+    double meanTileTime = 0.0;
+    double idleTime = 0.0;
+    double idleFraction = 0.0;
+};
+
+// With at most one tile per worker, the slowest tile sets the makespan and every other worker, including any left
+// without a tile, idles for the difference.
+LoadBalance computeLoadBalance(const std::vector<double>& tileTimes, int numThreads)
+{
+    LoadBalance balance;
+    if (tileTimes.empty() || numThreads <= 0)
+    {
+        return balance;
+    }
+
+    double total = 0.0;
+    for (double time : tileTimes)
+    {
+        balance.makespan = std::max(balance.makespan, time);
+        total += time;
+    }
+
+    balance.meanTileTime = total / static_cast<double>(tileTimes.size());
+    double workers = static_cast<double>(std::max(numThreads, static_cast<int>(tileTimes.size())));
+    balance.idleTime = balance.makespan * workers - total;
+    if (balance.makespan > 0)
+    {
+        balance.idleFraction = balance.idleTime / (balance.makespan * workers);
+    }
+    return balance;
+}
+
+void writeCounterCells(std::ostream& out, const HardwareCounters::Sample& sample)
+{
+    for (auto event : kReportedEvents)
+    {
+        out << ",";
+        if (sample.has(event))
+        {
+            out << sample.get(event);
+        }
+
+        if (event == HardwareCounters::Event::Instructions)
+        {
+            out << ",";
+            if (sample.ipc() > 0)
+            {
+                out << sample.ipc();
+            }
+        }
+    }
+
+    out << "," << (sample.anyUserOnly() ? 1 : 0);
+}
+
+} // namespace
+
 void PerformanceMetrics::startTimer(const std::string& name)
 {
     std::lock_guard<std::mutex> lock(mMutex);
@@ -52,6 +125,162 @@ double PerformanceMetrics::calculateEfficiency(const std::string& baseline, cons
     return 0.0;
 }
 
+void PerformanceMetrics::recordCounters(const std::string& name, const HardwareCounters::Sample& sample)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mCounters[name] = sample;
+}
+
+void PerformanceMetrics::recordTileCounters(const std::string& name,
+                                            const std::vector<HardwareCounters::Sample>& samples)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mTileCounters[name] = samples;
+}
+
+void PerformanceMetrics::recordTileTimes(const std::string& name, const std::vector<double>& seconds)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mTileTimes[name] = seconds;
+}
+
+void PerformanceMetrics::printLoadBalance(int numThreads) const
+{
+    std::unordered_map<std::string, std::vector<double>> tileTimes;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        tileTimes = mTileTimes;
+    }
+
+    if (tileTimes.empty())
+    {
+        return;
+    }
+
+    std::cout << "\n--- Load balance ---\n";
+
+    for (const auto& name : kReportedRuns)
+    {
+        auto it = tileTimes.find(name);
+        if (it == tileTimes.end())
+        {
+            continue;
+        }
+
+        LoadBalance balance = computeLoadBalance(it->second, numThreads);
+        std::cout << name << ": makespan " << balance.makespan << " s, mean tile " << balance.meanTileTime
+                  << " s, idle " << balance.idleTime << " s (" << (balance.idleFraction * 100.0)
+                  << "% of worker time)\n";
+    }
+
+    auto uniformIt = tileTimes.find("UniformGrid");
+    auto costModelIt = tileTimes.find("MultiThread");
+    if (uniformIt != tileTimes.end() && costModelIt != tileTimes.end())
+    {
+        LoadBalance uniform = computeLoadBalance(uniformIt->second, numThreads);
+        LoadBalance costModel = computeLoadBalance(costModelIt->second, numThreads);
+
+        if (costModel.makespan > 0)
+        {
+            std::cout << "Cost-model makespan speedup over uniform grid: " << (uniform.makespan / costModel.makespan)
+                      << "x\n";
+        }
+        std::cout << "Idle time change: " << (costModel.idleTime - uniform.idleTime) << " s\n";
+    }
+}
+
+void PerformanceMetrics::printCounters(const std::string& name) const
+{
+    HardwareCounters::Sample sample;
+    std::vector<HardwareCounters::Sample> tiles;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mCounters.find(name);
+        if (it == mCounters.end())
+        {
+            return;
+        }
+        sample = it->second;
+
+        auto tileIt = mTileCounters.find(name);
+        if (tileIt != mTileCounters.end())
+        {
+            tiles = tileIt->second;
+        }
+    }
+
+    std::cout << "\n--- Hardware counters: " << name << " ---\n";
+
+    if (!sample.hasAny())
+    {
+        std::cout << "Unavailable";
+        if (!HardwareCounters::unavailableReason().empty())
+        {
+            std::cout << " (" << HardwareCounters::unavailableReason() << ")";
+        }
+        std::cout << "\n";
+        return;
+    }
+
+    for (auto event : kReportedEvents)
+    {
+        std::cout << std::left << std::setw(18) << HardwareCounters::eventName(event) << ": ";
+        if (sample.has(event))
+        {
+            std::cout << sample.get(event) << (sample.isUserOnly(event) ? " (user)" : "") << "\n";
+        }
+        else
+        {
+            std::cout << "n/a\n";
+        }
+    }
+    std::cout << std::right;
+
+    if (sample.ipc() > 0)
+    {
+        std::cout << "IPC               : " << sample.ipc() << "\n";
+    }
+
+    if (sample.anyUserOnly())
+    {
+        std::cout << "(user) = user-space only; kernel counting is restricted by perf_event_paranoid\n";
+    }
+
+    if (tiles.empty())
+    {
+        return;
+    }
+
+    std::cout << std::setw(6) << "Tile" << std::setw(16) << "Cycles" << std::setw(16) << "Instructions"
+              << std::setw(8) << "IPC" << std::setw(12) << "LLC miss" << std::setw(8) << "CS" << std::setw(8)
+              << "Migr" << std::setw(6) << "User" << "\n";
+
+    for (size_t i = 0; i < tiles.size(); i++)
+    {
+        const auto& tile = tiles[i];
+        std::cout << std::setw(6) << (i + 1);
+        for (size_t e = 0; e < std::size(kReportedEvents); e++)
+        {
+            auto event = kReportedEvents[e];
+            int width = kTileColumnWidths[e];
+            if (tile.has(event))
+            {
+                std::cout << std::setw(width) << tile.get(event);
+            }
+            else
+            {
+                std::cout << std::setw(width) << "n/a";
+            }
+
+            if (event == HardwareCounters::Event::Instructions)
+            {
+                std::cout << std::setw(8) << std::setprecision(2) << tile.ipc() << std::setprecision(4);
+            }
+        }
+        std::cout << std::setw(6) << (tile.anyUserOnly() ? "yes" : "no") << "\n";
+    }
+}
+
 void PerformanceMetrics::printMetrics(int numThreads) const
 {
     std::cout << "\n=== Performance Metrics ===\n";
@@ -81,4 +310,65 @@ void PerformanceMetrics::printMetrics(int numThreads) const
         std::cout << "Theoretical maximum speedup: " << theoreticalMaxSpeedup << "x\n";
         std::cout << "Achieved " << (speedup / theoreticalMaxSpeedup * 100.0) << "% of theoretical maximum\n";
     }
+
+    printLoadBalance(numThreads);
+
+    for (const auto& name : kReportedRuns)
+    {
+        printCounters(name);
+    }
+}
+
+void PerformanceMetrics::exportReport(const std::string& filename, int numThreads, const std::string& strategy) const
+{
+    std::ofstream out(filename);
+    if (!out)
+    {
+        std::cerr << "Error: Could not write report to " << filename << "\n";
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    out << "run,strategy,threads,tile,seconds,cycles,instructions,ipc,llc_misses,context_switches,cpu_migrations,user_only\n";
+    out << std::fixed << std::setprecision(4);
+
+    for (const auto& name : kReportedRuns)
+    {
+        auto timeIt = mElapsedTimes.find(name);
+        auto counterIt = mCounters.find(name);
+        if (timeIt == mElapsedTimes.end() && counterIt == mCounters.end())
+        {
+            continue;
+        }
+
+        bool isBaseline = name == "SingleThread";
+        out << name << "," << (isBaseline ? "none" : strategy) << "," << (isBaseline ? 1 : numThreads) << ",all,";
+        if (timeIt != mElapsedTimes.end())
+        {
+            out << timeIt->second;
+        }
+        writeCounterCells(out, counterIt != mCounters.end() ? counterIt->second : HardwareCounters::Sample{});
+        out << "\n";
+
+        auto tileTimeIt = mTileTimes.find(name);
+        auto tileCounterIt = mTileCounters.find(name);
+        size_t numTiles = std::max(tileTimeIt != mTileTimes.end() ? tileTimeIt->second.size() : 0,
+                                   tileCounterIt != mTileCounters.end() ? tileCounterIt->second.size() : 0);
+
+        for (size_t i = 0; i < numTiles; i++)
+        {
+            out << name << "," << strategy << "," << numThreads << "," << (i + 1) << ",";
+            if (tileTimeIt != mTileTimes.end() && i < tileTimeIt->second.size())
+            {
+                out << tileTimeIt->second[i];
+            }
+
+            bool hasCounters = tileCounterIt != mTileCounters.end() && i < tileCounterIt->second.size();
+            writeCounterCells(out, hasCounters ? tileCounterIt->second[i] : HardwareCounters::Sample{});
+            out << "\n";
+        }
+    }
+
+    std::cout << "Saved metrics report to " << filename << "\n";
 }
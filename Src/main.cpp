@@ -1,15 +1,19 @@
 #include <iostream>
+#include <memory>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include <Processors/MultiThreadProcessor.h>
 #include <Processors/SingleThreadProcessor.h>
+#include <Utils/HardwareCounters.h>
 #include <Utils/PerformanceMetrics.h>
 #include <Utils/Visualizer.h>
 
 void printUsage(const char* programName)
 {
-    std::cout << "Usage: " << programName << " <image_path> [num_threads] [threading_strategy]\n";
+    std::cout << "Usage: " << programName
+              << " <image_path> [num_threads] [threading_strategy] [--counters] [--cost-model]\n";
     std::cout << "  <image_path>       : Path to the input image\n";
     std::cout << "  [num_threads]      : Number of threads to use (default: "
                  "number of CPU cores)\n";
@@ -18,26 +22,49 @@ void printUsage(const char* programName)
     std::cout << "                        - async     : Use std::async\n";
     std::cout << "                        - threadpool: Use thread pool\n";
     std::cout << "                        - jthread   : Use std::jthread\n";
+    std::cout << "  [--counters]       : Collect hardware performance counters per run and per tile\n";
+    std::cout << "  [--cost-model]     : Partition by predicted cost instead of equal area, compared\n";
+    std::cout << "                       against a calibrating run on the uniform grid\n";
 }
 
 int main(int argc, char** argv)
 {
-    if (argc < 2)
+    bool collectCounters = false;
+    bool useCostModel = false;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--counters")
+        {
+            collectCounters = true;
+        }
+        else if (arg == "--cost-model")
+        {
+            useCostModel = true;
+        }
+        else
+        {
+            args.push_back(arg);
+        }
+    }
+
+    if (args.empty())
     {
         printUsage(argv[0]);
         return 1;
     }
 
-    std::string imagePath = argv[1];
+    std::string imagePath = args[0];
     auto numThreads = static_cast<int>(std::thread::hardware_concurrency());
     MultiThreadProcessor::ThreadingStrategy strategy = MultiThreadProcessor::ThreadingStrategy::ThreadPool;
     std::cout << "Detected " << numThreads << " hardware threads\n";
 
-    if (argc >= 3)
+    if (args.size() >= 2)
     {
         try
         {
-            numThreads = std::stoi(argv[2]);
+            numThreads = std::stoi(args[1]);
             if (numThreads <= 0)
             {
                 std::cerr << "Error: Number of threads must be positive\n";
@@ -51,9 +78,9 @@ int main(int argc, char** argv)
         }
     }
 
-    if (argc >= 4)
+    if (args.size() >= 3)
     {
-        std::string strategyArg = argv[3];
+        std::string strategyArg = args[2];
         if (strategyArg == "async")
         {
             strategy = MultiThreadProcessor::ThreadingStrategy::Async;
@@ -74,22 +101,42 @@ int main(int argc, char** argv)
         }
     }
 
+    std::string strategyName;
     std::cout << "Using " << numThreads << " threads with ";
     switch (strategy)
     {
     case MultiThreadProcessor::ThreadingStrategy::Async:
         std::cout << "std::async strategy\n";
+        strategyName = "async";
         break;
     case MultiThreadProcessor::ThreadingStrategy::ThreadPool:
         std::cout << "thread pool strategy\n";
+        strategyName = "threadpool";
         break;
     case MultiThreadProcessor::ThreadingStrategy::JThread:
         std::cout << "std::jthread strategy\n";
+        strategyName = "jthread";
         break;
     }
 
+    if (collectCounters && !HardwareCounters::isSupported())
+    {
+        std::cout << "Hardware counters unavailable (" << HardwareCounters::unavailableReason()
+                  << "), reporting wall-clock time only\n";
+        collectCounters = false;
+    }
+
     cv::utils::logging::setLogLevel(cv::utils::logging::LOG_LEVEL_ERROR);
 
+    if (collectCounters)
+    {
+        // bilateralFilter and detailEnhance would otherwise fan out to OpenCV's own worker pool, whose work the
+        // per-thread hardware counters cannot see.
+        cv::setNumThreads(1);
+        std::cout << "OpenCV internal threading disabled for counter collection: each region is processed by "
+                     "exactly one thread\n";
+    }
+
     cv::Mat inputImage = cv::imread(imagePath);
     if (inputImage.empty())
     {
@@ -101,22 +148,68 @@ int main(int argc, char** argv)
 
     SingleThreadProcessor singleProcessor;
     MultiThreadProcessor multiProcessor(numThreads, strategy);
+    multiProcessor.setCounterCollection(collectCounters);
 
     PerformanceMetrics metrics;
 
     std::cout << "Processing with single thread...\n";
+    std::unique_ptr<HardwareCounters> singleThreadCounters;
+    if (collectCounters)
+    {
+        singleThreadCounters = std::make_unique<HardwareCounters>();
+    }
+
     metrics.startTimer("SingleThread");
+    if (singleThreadCounters)
+    {
+        singleThreadCounters->start();
+    }
     cv::Mat singleThreadResult = singleProcessor.process(inputImage);
+    if (singleThreadCounters)
+    {
+        metrics.recordCounters("SingleThread", singleThreadCounters->stop());
+    }
     metrics.stopTimer("SingleThread");
 
+    if (useCostModel)
+    {
+        // Untimed calibration run; it also warms caches, the allocator and the workers, so the timed uniform-grid
+        // and cost-model runs below start from the same state and neither is the run the model was fitted to.
+        std::cout << "Calibrating cost model on the uniform grid...\n";
+        multiProcessor.process(inputImage);
+        multiProcessor.calibrateCostModel(inputImage);
+
+        std::cout << "Processing with " << numThreads << " threads on the uniform grid...\n";
+        metrics.startTimer("UniformGrid");
+        multiProcessor.process(inputImage);
+        metrics.stopTimer("UniformGrid");
+
+        metrics.recordTileTimes("UniformGrid", multiProcessor.getTileTimes());
+        if (collectCounters)
+        {
+            metrics.recordCounters("UniformGrid", multiProcessor.getRunCounters());
+            metrics.recordTileCounters("UniformGrid", multiProcessor.getTileCounters());
+        }
+
+        multiProcessor.setPartitionStrategy(MultiThreadProcessor::PartitionStrategy::CostModel);
+    }
+
     std::cout << "Processing with " << numThreads << " threads...\n";
     metrics.startTimer("MultiThread");
     cv::Mat multiThreadResult = multiProcessor.process(inputImage);
     metrics.stopTimer("MultiThread");
 
+    metrics.recordTileTimes("MultiThread", multiProcessor.getTileTimes());
+    if (collectCounters)
+    {
+        metrics.recordCounters("MultiThread", multiProcessor.getRunCounters());
+        metrics.recordTileCounters("MultiThread", multiProcessor.getTileCounters());
+    }
+
     metrics.printMetrics(numThreads);
+    metrics.exportReport("metrics_report.csv", numThreads, strategyName);
 
-    auto regions = multiProcessor.divideImageIntoRegions(inputImage);
+    auto regions = multiProcessor.getLastRegions();
 
     Visualizer::saveTimingChart("timing_chart.png", metrics.getElapsedTime("SingleThread"),
                                 metrics.getElapsedTime("MultiThread"), numThreads);